@@ -0,0 +1,362 @@
+#include "batch.h"
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include <unordered_set>
+#include "links.h"
+#include "parser.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// progress of one manual while its files are being converted
+struct ManualState {
+    std::vector<std::string> mdFiles;
+    std::vector<Page> pages; // one slot per file, so workers never share a slot
+    std::atomic<size_t> remaining{0};
+    std::atomic<long long> workNanoseconds{0};
+    std::mutex errorMutex;
+    std::string error;
+    std::vector<std::string> brokenLinks;
+    Clock::time_point finished;
+
+    void fail(const std::string& message) {
+        std::lock_guard<std::mutex> lock(errorMutex);
+        if (error.empty()) {
+            error = message;
+        }
+    }
+};
+
+// section ids are only unique within their file, so a section can clash with another file's page
+// or section, and an index.md clashes with the generated home page. suffix the clashing ids
+// before anything is linked or written
+void makePageIdsUnique(std::vector<Page> &pages) {
+    std::unordered_set<std::string> taken{"index"};
+
+    auto uniqueId = [&taken](const std::string &id) {
+        std::string candidate;
+        size_t suffix = 2;
+        do {
+            candidate = id + "-" + std::to_string(suffix++);
+        } while (!taken.insert(candidate).second);
+        return candidate;
+    };
+
+    // file names are unique, so only the home page can clash with a top-level page
+    std::vector<Page *> clashing;
+    for (auto &page: pages) {
+        if (!taken.insert(page.id).second) {
+            clashing.push_back(&page);
+        }
+    }
+    for (auto *page: clashing) {
+        page->id = uniqueId(page->id);
+    }
+
+    for (auto &page: pages) {
+        for (auto &section: page.sections) {
+            if (!taken.insert(section.id).second) {
+                section.id = uniqueId(section.id);
+            }
+        }
+    }
+}
+
+double toMilliseconds(Clock::duration duration) {
+    return std::chrono::duration<double, std::milli>(duration).count();
+}
+
+} // namespace
+
+BatchRunner::BatchRunner(const BuildOptions &options, size_t workerCount)
+    : options(options), workerCount(workerCount == 0 ? 1 : workerCount) {
+}
+
+std::vector<ManualJob> BatchRunner::readManifest(const std::string &manifestPath) {
+    std::ifstream file(manifestPath);
+    if (!file.is_open()) {
+        throw std::runtime_error("Could not open manifest: " + manifestPath);
+    }
+
+    std::vector<ManualJob> jobs;
+    std::unordered_set<std::string> outputDirs;
+    std::string line;
+    size_t lineNumber = 0;
+
+    while (std::getline(file, line)) {
+        lineNumber++;
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+
+        std::vector<std::string> fields;
+        std::istringstream stream(line);
+        std::string field;
+        while (std::getline(stream, field, '\t')) {
+            fields.push_back(field);
+        }
+
+        if (fields.size() < 2 || fields[0].empty() || fields[1].empty()) {
+            throw std::runtime_error("Invalid manifest entry on line " + std::to_string(lineNumber) +
+                                     ": expected tab-separated <input_dir> <output_dir> [title] [author]");
+        }
+
+        // manuals run in parallel, so two of them must never write to the same directory
+        const std::string outputPath = (fs::weakly_canonical(fields[1]) / "").string();
+        if (!outputDirs.insert(outputPath).second) {
+            throw std::runtime_error("Duplicate output directory on line " + std::to_string(lineNumber) + ": " +
+                                     fields[1]);
+        }
+
+        ManualJob job;
+        job.inputDir = fields[0];
+        job.outputDir = fields[1];
+        if (fields.size() > 2 && !fields[2].empty()) {
+            job.title = fields[2];
+        }
+        if (fields.size() > 3) {
+            job.author = fields[3];
+        }
+        jobs.push_back(job);
+    }
+
+    return jobs;
+}
+
+std::vector<ManualResult> BatchRunner::run(const std::vector<ManualJob> &jobs) const {
+    const auto start = Clock::now();
+
+    std::vector<ManualResult> results(jobs.size());
+    std::vector<std::unique_ptr<ManualState>> states;
+
+    // one task per markdown file across all manuals
+    std::vector<std::pair<size_t, size_t>> tasks;
+
+    for (size_t i = 0; i < jobs.size(); i++) {
+        const ManualJob &job = jobs[i];
+        results[i].outputDir = job.outputDir;
+        states.push_back(std::make_unique<ManualState>());
+        ManualState &state = *states.back();
+
+        // a filesystem error in one job must not stop the other manuals
+        try {
+            // Check if input directory exists
+            if (!fs::exists(job.inputDir) || !fs::is_directory(job.inputDir)) {
+                results[i].error = "Input directory does not exist or is not a directory.";
+                continue;
+            }
+
+            // Create output directory if it doesn't exist
+            if (!fs::exists(job.outputDir)) {
+                if (!fs::create_directories(job.outputDir)) {
+                    results[i].error = "Could not create output directory.";
+                    continue;
+                }
+            }
+
+            // Collect markdown files
+            for (const auto &entry: fs::directory_iterator(job.inputDir)) {
+                if (entry.is_regular_file() && entry.path().extension() == ".md") {
+                    state.mdFiles.push_back(entry.path().string());
+                }
+            }
+        }
+        catch (const std::exception &e) {
+            results[i].error = e.what();
+            continue;
+        }
+
+        if (state.mdFiles.empty()) {
+            results[i].error = "No markdown files found in the input directory.";
+            continue;
+        }
+
+        state.pages.resize(state.mdFiles.size());
+        state.remaining = state.mdFiles.size();
+        results[i].fileCount = state.mdFiles.size();
+
+        for (size_t f = 0; f < state.mdFiles.size(); f++) {
+            tasks.emplace_back(i, f);
+        }
+    }
+
+    // writes a manual once all of its files are converted
+    auto finishManual = [&](size_t manualIndex) {
+        const ManualJob &job = jobs[manualIndex];
+        ManualState &state = *states[manualIndex];
+        const auto taskStart = Clock::now();
+
+        if (state.error.empty()) {
+            try {
+                makePageIdsUnique(state.pages);
+
+                // resolve links between files once every page and anchor of the manual is known
+                LinkIndex linkIndex;
+                for (const auto &page: state.pages) {
+                    linkIndex.addPage(page);
+                }
+                for (auto &page: state.pages) {
+                    for (const auto &target: linkIndex.resolvePage(page)) {
+                        state.brokenLinks.push_back(page.id + ".md: " + target);
+                    }
+                }
+
+                if (options.strictLinks && !state.brokenLinks.empty()) {
+                    throw std::runtime_error(std::to_string(state.brokenLinks.size()) + " broken link(s)");
+                }
+
+                Generator generator(job.title, job.outputDir, job.author);
+                generator.setInlineStylesheet(options.inlineCss);
+                for (const auto &page: state.pages) {
+                    generator.addPage(page);
+                }
+
+                // Generate the manual
+                generator.generate();
+            }
+            catch (const std::exception &e) {
+                state.fail(e.what());
+            }
+        }
+
+        // a failed manual must not leave streamed content behind in its output directory
+        if (!state.error.empty()) {
+            for (const auto &page: state.pages) {
+                if (!page.contentFile.empty()) {
+                    std::error_code error;
+                    fs::remove(page.contentFile, error);
+                }
+            }
+        }
+
+        state.finished = Clock::now();
+        state.workNanoseconds += std::chrono::duration_cast<std::chrono::nanoseconds>(
+            state.finished - taskStart).count();
+    };
+
+    std::atomic<size_t> nextTask{0};
+    auto worker = [&]() {
+        for (size_t t = nextTask++; t < tasks.size(); t = nextTask++) {
+            const auto [manualIndex, fileIndex] = tasks[t];
+            ManualState &state = *states[manualIndex];
+            const auto taskStart = Clock::now();
+
+            try {
+                state.pages[fileIndex] = convertFile(state.mdFiles[fileIndex], jobs[manualIndex].outputDir);
+            }
+            catch (const std::exception &e) {
+                state.fail(e.what());
+            }
+
+            state.workNanoseconds += std::chrono::duration_cast<std::chrono::nanoseconds>(
+                Clock::now() - taskStart).count();
+
+            // the worker converting the last file of a manual also writes it
+            if (--state.remaining == 0) {
+                finishManual(manualIndex);
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+    const size_t threadCount = std::min(workerCount, tasks.size());
+    for (size_t i = 1; i < threadCount; i++) {
+        threads.emplace_back(worker);
+    }
+    worker();
+    for (auto &thread: threads) {
+        thread.join();
+    }
+
+    for (size_t i = 0; i < jobs.size(); i++) {
+        const ManualState &state = *states[i];
+        if (!results[i].error.empty()) {
+            continue;
+        }
+
+        results[i].error = state.error;
+        results[i].brokenLinks = state.brokenLinks;
+        results[i].workMilliseconds = state.workNanoseconds / 1e6;
+        results[i].finishedMilliseconds = toMilliseconds(state.finished - start);
+    }
+
+    return results;
+}
+
+Page BatchRunner::convertFile(const std::string &mdFile, const std::string &outputDir) const {
+    fs::path filePath(mdFile);
+
+    Page page;
+    page.id = filePath.stem().string();
+    page.source = page.id;
+
+    if (options.streaming) {
+        // Convert each block as soon as it is parsed, keeping only one block in memory
+        page.contentFile = (fs::path(outputDir) / (page.id + ".html.part")).string();
+        std::ofstream partFile(page.contentFile);
+        if (!partFile) {
+            throw std::runtime_error("Could not write file: " + page.contentFile);
+        }
+
+        MarkdownDocument summary;
+        try {
+            summary = Parser::parseStream(mdFile, [&partFile](MarkdownElement &&element) {
+                partFile << Converter::convertElement(element);
+            });
+        }
+        catch (...) {
+            partFile.close();
+            fs::remove(page.contentFile);
+            throw;
+        }
+        partFile.close();
+
+        page.title = summary.title;
+        page.anchors = std::move(summary.anchors);
+        page.links = std::move(summary.links);
+    }
+    else {
+        // Parse markdown file
+        Parser parser(mdFile);
+        auto mdContent = parser.parse();
+        page.title = mdContent.title;
+        page.links = mdContent.links;
+
+        if (Converter::shouldSplit(mdContent, options.split)) {
+            // Split oversized documents into one sub-page per H2 section
+            auto sections = Converter::convertSections(mdContent, page.id);
+            page.content = sections[0].content;
+            page.anchors = sections[0].anchors;
+
+            for (size_t i = 1; i < sections.size(); i++) {
+                Page section;
+                section.id = sections[i].id;
+                section.title = sections[i].title;
+                section.content = sections[i].content;
+                section.anchors = sections[i].anchors;
+                page.sections.push_back(section);
+            }
+        }
+        else {
+            // Convert markdown to HTML
+            page.content = Converter::convert(mdContent);
+            page.anchors = mdContent.anchors;
+        }
+    }
+
+    if (page.title.empty()) {
+        page.title = page.id;
+    }
+
+    return page;
+}
@@ -0,0 +1,53 @@
+#ifndef BATCH_H
+#define BATCH_H
+
+#include <string>
+#include <vector>
+#include "converter.h"
+#include "generator.h"
+
+// options that apply to every manual of a run
+struct BuildOptions {
+    bool streaming = false;
+    bool strictLinks = false; // fail a manual that contains dangling links
+    bool inlineCss = false;   // embed the stylesheet in every page instead of linking it
+    SplitOptions split;
+};
+
+// one manual to build: the positional arguments of a single md2man invocation
+struct ManualJob {
+    std::string inputDir;
+    std::string outputDir;
+    std::string title = "Reference Manual";
+    std::string author;
+};
+
+struct ManualResult {
+    std::string outputDir;
+    size_t fileCount = 0;
+    double workMilliseconds = 0;     // time spent on this manual summed over all workers
+    double finishedMilliseconds = 0; // wall-clock time from the start of the run until the manual was written
+    std::string error;               // empty on success
+    std::vector<std::string> brokenLinks; // "file.md: target" for every dangling link
+};
+
+// builds any number of manuals on one shared pool of worker threads. files of all
+// manuals are scheduled together, and each manual is written as soon as its last file is converted
+class BatchRunner {
+public:
+    BatchRunner(const BuildOptions& options, size_t workerCount);
+
+    // reads one job per line: input_dir, output_dir and optional title and author, separated by tabs.
+    // empty lines and lines starting with # are ignored
+    static std::vector<ManualJob> readManifest(const std::string& manifestPath);
+
+    [[nodiscard]] std::vector<ManualResult> run(const std::vector<ManualJob>& jobs) const;
+
+private:
+    BuildOptions options;
+    size_t workerCount;
+
+    [[nodiscard]] Page convertFile(const std::string& mdFile, const std::string& outputDir) const;
+};
+
+#endif
@@ -1,6 +1,7 @@
 #include "converter.h"
 #include <sstream>
 #include <algorithm>
+#include <unordered_set>
 #include "utils.h"
 
 Converter::Converter() {
@@ -16,6 +17,81 @@ std::string Converter::convert(const MarkdownDocument &document) {
     return html.str();
 }
 
+bool Converter::shouldSplit(const MarkdownDocument &document, const SplitOptions &options) {
+    if (!options.enabled()) {
+        return false;
+    }
+
+    size_t bytes = 0;
+    size_t sections = 0;
+    for (const auto &element: document.elements) {
+        bytes += contentSize(element);
+        if (element.type == MarkdownElement::HEADING && element.level == 2) {
+            sections++;
+        }
+    }
+
+    // without any H2 there is nothing to split at
+    if (sections == 0) {
+        return false;
+    }
+
+    return (options.maxBytes > 0 && bytes > options.maxBytes) ||
+           (options.maxSections > 0 && sections > options.maxSections);
+}
+
+size_t Converter::contentSize(const MarkdownElement &element) {
+    size_t size = element.content.size();
+    for (const auto &child: element.children) {
+        size += contentSize(child);
+    }
+    return size;
+}
+
+std::vector<DocumentSection> Converter::convertSections(const MarkdownDocument &document, const std::string &pageId) {
+    // first pass: assign every element to a section and record the heading anchors of each section.
+    // links to anchors that end up in another section are rewritten later by LinkIndex
+    std::vector<DocumentSection> sections(1);
+    sections[0].id = pageId;
+    sections[0].title = document.title.empty() ? pageId : document.title;
+
+    std::vector<size_t> elementSections;
+    std::unordered_set<std::string> usedIds{pageId};
+
+    for (const auto &element: document.elements) {
+        if (element.type == MarkdownElement::HEADING && element.level == 2) {
+            std::string id = pageId + "-" + utils::slugify(element.content);
+            if (id.back() == '-' || usedIds.count(id) > 0) {
+                id = pageId + "-" + std::to_string(sections.size());
+            }
+            usedIds.insert(id);
+
+            DocumentSection section;
+            section.id = id;
+            section.title = element.content;
+            sections.push_back(section);
+        }
+
+        if (element.type == MarkdownElement::HEADING) {
+            sections.back().anchors.push_back(utils::slugify(element.content));
+        }
+
+        elementSections.push_back(sections.size() - 1);
+    }
+
+    // second pass: convert each element into its section
+    std::vector<std::stringstream> html(sections.size());
+    for (size_t i = 0; i < document.elements.size(); i++) {
+        html[elementSections[i]] << convertElement(document.elements[i]);
+    }
+
+    for (size_t i = 0; i < sections.size(); i++) {
+        sections[i].content = html[i].str();
+    }
+
+    return sections;
+}
+
 std::string Converter::convertElement(const MarkdownElement &element) {
     switch (element.type) {
         case MarkdownElement::HEADING:
@@ -2,15 +2,39 @@
 #define CONVERTER_H
 
 #include <string>
+#include <vector>
 #include "parser.h"
 
+// thresholds above which a document is split at its H2 headings (0 = no limit)
+struct SplitOptions {
+    size_t maxBytes = 0;
+    size_t maxSections = 0;
+
+    [[nodiscard]] bool enabled() const { return maxBytes > 0 || maxSections > 0; }
+};
+
+// one separately written part of a split document
+struct DocumentSection {
+    std::string id;
+    std::string title;
+    std::string content;
+    std::vector<std::string> anchors; // slugs of the headings in this section
+};
+
 class Converter {
 public:
     Converter();
     static std::string convert(const MarkdownDocument& document);
+    static std::string convertElement(const MarkdownElement& element);
+
+    static bool shouldSplit(const MarkdownDocument& document, const SplitOptions& options);
+    // the first section is the landing part before the first H2, followed by one section per H2.
+    // section ids are only unique within the document; callers must check them against the whole manual
+    static std::vector<DocumentSection> convertSections(const MarkdownDocument& document, const std::string& pageId);
 
 private:
-    static std::string convertElement(const MarkdownElement& element);
+    static size_t contentSize(const MarkdownElement& element);
+
 
     static std::string convertHeading(const MarkdownElement& element);
 
@@ -2,6 +2,10 @@
 #include <fstream>
 #include <iostream>
 #include <algorithm>
+#include <sstream>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
 #include "utils.h"
 
 Generator::Generator(const std::string &manualTitle, const std::string &outputDir,
@@ -19,14 +23,20 @@ void Generator::addPage(const std::string &id, const std::string &title, const s
     pages.push_back(page);
 }
 
+void Generator::addPage(const Page &page) {
+    pages.push_back(page);
+    if (pages.back().title.empty()) {
+        pages.back().title = page.id;
+    }
+}
+
 void Generator::generate() {
     // sort pages alphabetically by title
     std::sort(pages.begin(), pages.end(),
               [](const Page &a, const Page &b) { return a.title < b.title; });
 
     // create necessary directories and files
-    fs::create_directories(fs::path(outputDir) / "css");
-    fs::create_directories(fs::path(outputDir) / "js");
+    fs::create_directories(fs::path(outputDir) / "fragments");
 
     createStylesheet();
     createScripts();
@@ -34,40 +44,90 @@ void Generator::generate() {
     createContentPages();
 }
 
-void Generator::createStylesheet() const {
-    std::string cssOutput = (fs::path(outputDir) / "css" / "style.css").string();
+const std::string *Generator::loadTemplate(const std::string &path) {
+    static std::mutex cacheMutex;
+    static std::unordered_map<std::string, std::unique_ptr<std::string>> cache;
 
-    // Read from template file
-    std::ifstream templateFile(cssTemplatePath);
-    if (!templateFile) {
-        std::cerr << "Warning: Could not open CSS template file: " << cssTemplatePath << std::endl;
-        return;
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    const auto it = cache.find(path);
+    if (it != cache.end()) {
+        return it->second.get();
     }
 
-    // Copy to output file
-    std::ofstream outputFile(cssOutput);
-    outputFile << templateFile.rdbuf();
+    // a missing template is cached too, so the warning is only printed once
+    std::unique_ptr<std::string> content;
+    std::ifstream templateFile(path);
+    if (templateFile) {
+        std::stringstream buffer;
+        buffer << templateFile.rdbuf();
+        content = std::make_unique<std::string>(buffer.str());
+    }
+    else {
+        std::cerr << "Warning: Could not open template file: " << path << std::endl;
+    }
+
+    return cache.emplace(path, std::move(content)).first->second.get();
+}
 
-    templateFile.close();
-    outputFile.close();
+void Generator::setInlineStylesheet(bool inlineStylesheet) {
+    this->inlineStylesheet = inlineStylesheet;
 }
 
-void Generator::createScripts() const {
-    std::string jsOutput = (fs::path(outputDir) / "js" / "script.js").string();
+void Generator::createStylesheet() {
+    const std::string *css = loadTemplate(cssTemplatePath);
+    if (!css) {
+        return;
+    }
+
+    if (inlineStylesheet) {
+        inlineCss = *css;
+        return;
+    }
+
+    stylesheetUrl = writeAsset("css", "style", ".css", *css);
+}
 
-    // Read from template file
-    std::ifstream templateFile(jsTemplatePath);
-    if (!templateFile) {
-        std::cerr << "Warning: Could not open JS template file: " << jsTemplatePath << std::endl;
+void Generator::createScripts() {
+    const std::string *js = loadTemplate(jsTemplatePath);
+    if (!js) {
         return;
     }
 
-    // Copy to output file
-    std::ofstream outputFile(jsOutput);
-    outputFile << templateFile.rdbuf();
+    scriptUrl = writeAsset("js", "script", ".js", *js);
+}
+
+std::string Generator::writeAsset(const std::string &directory, const std::string &name,
+                                  const std::string &extension, const std::string &content) const {
+    // name assets by content hash so they can be cached forever
+    const std::string fileName = name + "." + utils::contentHash(content) + extension;
+    const fs::path assetPath = fs::path(outputDir) / directory / fileName;
+    fs::create_directories(assetPath.parent_path());
+
+    // skip the copy if an identical asset is already in place
+    bool upToDate = false;
+    std::error_code error;
+    if (fs::file_size(assetPath, error) == content.size() && !error) {
+        std::ifstream existingFile(assetPath);
+        std::stringstream existing;
+        existing << existingFile.rdbuf();
+        upToDate = existing.str() == content;
+    }
+
+    if (!upToDate) {
+        std::ofstream outputFile(assetPath.string());
+        outputFile << content;
+        outputFile.close();
+    }
+
+    return directory + "/" + fileName;
+}
+
+std::string Generator::generateStylesheetTag() const {
+    if (!inlineCss.empty()) {
+        return "    <style>\n" + inlineCss + "    </style>\n";
+    }
 
-    templateFile.close();
-    outputFile.close();
+    return "    <link rel=\"stylesheet\" href=\"" + stylesheetUrl + "\">\n";
 }
 
 void Generator::createIndexPage() {
@@ -79,98 +139,198 @@ void Generator::createIndexPage() {
             << "    <meta charset=\"UTF-8\">\n"
             << "    <meta name=\"viewport\" content=\"width=device-width, initial-scale=1.0\">\n"
             << "    <title>" << manualTitle << "</title>\n"
-            << "    <link rel=\"stylesheet\" href=\"css/style.css\">\n"
+            << generateStylesheetTag()
             << "</head>\n"
             << "<body>\n"
             << "    <nav class=\"sidebar\">\n"
             << "        <div class=\"sidebar-header\">\n"
             << "            <h1>" << manualTitle << "</h1>\n"
             << "        </div>\n"
-            << "        <ul class=\"nav-list\">\n";
-
-    // add index page link (always active on index page)
-    indexFile << "            <li class=\"nav-item\">\n"
-            << "                <a class=\"nav-link active\" href=\"index.html\">Home</a>\n"
-            << "            </li>\n";
-
-    // add links to all pages
-    for (const auto &page: pages) {
-        indexFile << "            <li class=\"nav-item\">\n"
-                << R"(                <a class="nav-link" href=")" << page.id << ".html\">" << page.title << "</a>\n"
-                << "            </li>\n";
-    }
-
-    indexFile << "        </ul>\n"
+            << "        <ul class=\"nav-list\">\n"
+            << generateNavigation("index")
+            << "        </ul>\n"
             << "    </nav>\n"
-            << "    <main class=\"content\">\n"
-            << "        <h1>" << manualTitle << "</h1>\n";
+            << "    <main class=\"content\">\n";
+
+    std::stringstream main;
+    main << "        <h1>" << manualTitle << "</h1>\n";
 
     if (!author.empty()) {
-        indexFile << "        <p class=\"author\">By " << author << "</p>\n";
+        main << "        <p class=\"author\">By " << author << "</p>\n";
     }
 
-    indexFile << "        <div id=\"toc\"></div>\n"
+    main << "        <div id=\"toc\"></div>\n"
             << "        <p>Welcome to the " << manualTitle <<
             ". This manual provides comprehensive documentation generated from markdown files.</p>\n"
             << "        <h2>Contents</h2>\n"
             << "        <ul>\n";
 
     for (const auto &page: pages) {
-        indexFile << "            <li><a href=\"" << page.id << ".html\">" << page.title << "</a></li>\n";
+        main << "            <li><a href=\"" << page.id << ".html\">" << page.title << "</a></li>\n";
     }
 
-    indexFile << "        </ul>\n"
+    main << "        </ul>\n";
+
+    indexFile << main.str()
             << "    </main>\n"
-            << "    <script src=\"js/script.js\"></script>\n"
+            << "    <script src=\"" << scriptUrl << "\"></script>\n"
             << "</body>\n"
             << "</html>\n";
 
+    std::ofstream fragmentFile = openFragment("index", manualTitle);
+    fragmentFile << main.str()
+            << "    </main>\n";
+    fragmentFile.close();
+
     indexFile.close();
 }
 
 void Generator::createContentPages() {
     for (const auto &page: pages) {
-        std::ofstream pageFile((fs::path(outputDir) / (page.id + ".html")).string());
-
-        pageFile << "<!DOCTYPE html>\n"
-                << "<html lang=\"en\">\n"
-                << "<head>\n"
-                << "    <meta charset=\"UTF-8\">\n"
-                << "    <meta name=\"viewport\" content=\"width=device-width, initial-scale=1.0\">\n"
-                << "    <title>" << page.title << " - " << manualTitle << "</title>\n"
-                << "    <link rel=\"stylesheet\" href=\"css/style.css\">\n"
-                << "</head>\n"
-                << "<body>\n"
-                << "    <nav class=\"sidebar\">\n"
-                << "        <div class=\"sidebar-header\">\n"
-                << "            <h1>" << manualTitle << "</h1>\n"
-                << "        </div>\n"
-                << "        <ul class=\"nav-list\">\n";
-
-        // add index page link
-        pageFile << "            <li class=\"nav-item\">\n"
-                << "                <a class=\"nav-link\" href=\"index.html\">Home</a>\n"
-                << "            </li>\n";
-
-        // add links to all pages with current page marked active
-        for (const auto &p: pages) {
-            pageFile << "            <li class=\"nav-item\">\n"
-                    << "                <a class=\"nav-link" << (p.id == page.id ? " active" : "") << "\" href=\""
-                    << p.id << ".html\">" << p.title << "</a>\n"
-                    << "            </li>\n";
+        std::string footer;
+        if (!page.sections.empty()) {
+            footer = generateSectionList(page) + generatePageLinks(nullptr, &page.sections.front());
+        }
+        writeContentPage(page, page.title, footer);
+
+        // sub-pages keep the file title as heading and link to their neighbours
+        for (size_t i = 0; i < page.sections.size(); i++) {
+            const Page *previous = i == 0 ? &page : &page.sections[i - 1];
+            const Page *next = i + 1 < page.sections.size() ? &page.sections[i + 1] : nullptr;
+            writeContentPage(page.sections[i], page.title, generatePageLinks(previous, next));
         }
+    }
+}
 
-        pageFile << "        </ul>\n"
-                << "    </nav>\n"
-                << "    <main class=\"content\">\n"
-                << "        <h1>" << page.title << "</h1>\n"
-                << "        <div id=\"toc\"></div>\n"
-                << page.content << "\n"
-                << "    </main>\n"
-                << "    <script src=\"js/script.js\"></script>\n"
-                << "</body>\n"
-                << "</html>\n";
+void Generator::writeContentPage(const Page &page, const std::string &heading, const std::string &footer) {
+    std::ofstream pageFile((fs::path(outputDir) / (page.id + ".html")).string());
 
-        pageFile.close();
+    pageFile << "<!DOCTYPE html>\n"
+            << "<html lang=\"en\">\n"
+            << "<head>\n"
+            << "    <meta charset=\"UTF-8\">\n"
+            << "    <meta name=\"viewport\" content=\"width=device-width, initial-scale=1.0\">\n"
+            << "    <title>" << page.title << " - " << manualTitle << "</title>\n"
+            << generateStylesheetTag()
+            << "</head>\n"
+            << "<body>\n"
+            << "    <nav class=\"sidebar\">\n"
+            << "        <div class=\"sidebar-header\">\n"
+            << "            <h1>" << manualTitle << "</h1>\n"
+            << "        </div>\n"
+            << "        <ul class=\"nav-list\">\n"
+            << generateNavigation(page.id)
+            << "        </ul>\n"
+            << "    </nav>\n"
+            << "    <main class=\"content\">\n";
+
+    writeMainContent(pageFile, page, heading, footer);
+
+    pageFile << "    </main>\n"
+            << "    <script src=\"" << scriptUrl << "\"></script>\n"
+            << "</body>\n"
+            << "</html>\n";
+
+    pageFile.close();
+
+    std::ofstream fragmentFile = openFragment(page.id, page.title + " - " + manualTitle);
+    writeMainContent(fragmentFile, page, heading, footer);
+    fragmentFile << "    </main>\n";
+    fragmentFile.close();
+
+    if (!page.contentFile.empty()) {
+        fs::remove(page.contentFile);
     }
 }
+
+void Generator::writeMainContent(std::ostream &out, const Page &page, const std::string &heading,
+                                 const std::string &footer) {
+    out << "        <h1>" << heading << "</h1>\n"
+            << "        <div id=\"toc\"></div>\n";
+
+    if (!page.contentFile.empty()) {
+        // copy the pre-converted body without loading it into memory
+        std::ifstream contentFile(page.contentFile);
+        if (contentFile.peek() != std::ifstream::traits_type::eof()) {
+            out << contentFile.rdbuf();
+        }
+        contentFile.close();
+    }
+    else {
+        out << page.content;
+    }
+
+    out << "\n"
+            << footer;
+}
+
+std::ofstream Generator::openFragment(const std::string &pageId, const std::string &documentTitle) const {
+    // fragments hold only the main element so the client script can swap pages without a full reload
+    std::ofstream fragmentFile((fs::path(outputDir) / "fragments" / (pageId + ".html")).string());
+    fragmentFile << "<main class=\"content\" data-title=\"" << utils::escapeHtml(documentTitle) << "\">\n";
+    return fragmentFile;
+}
+
+std::string Generator::generateNavigation(const std::string &currentPageId) {
+    std::stringstream nav;
+
+    // add index page link
+    nav << "            <li class=\"nav-item\">\n"
+            << "                <a class=\"nav-link" << (currentPageId == "index" ? " active" : "")
+            << "\" href=\"index.html\">Home</a>\n"
+            << "            </li>\n";
+
+    // add links to all pages with current page marked active
+    for (const auto &p: pages) {
+        nav << "            <li class=\"nav-item\">\n"
+                << "                <a class=\"nav-link" << (p.id == currentPageId ? " active" : "") << "\" href=\""
+                << p.id << ".html\">" << p.title << "</a>\n";
+
+        // split pages list their sections underneath
+        if (!p.sections.empty()) {
+            nav << "                <ul class=\"nav-sublist\">\n";
+            for (const auto &section: p.sections) {
+                nav << "                    <li class=\"nav-item\">\n"
+                        << "                        <a class=\"nav-link"
+                        << (section.id == currentPageId ? " active" : "") << "\" href=\""
+                        << section.id << ".html\">" << section.title << "</a>\n"
+                        << "                    </li>\n";
+            }
+            nav << "                </ul>\n";
+        }
+
+        nav << "            </li>\n";
+    }
+
+    return nav.str();
+}
+
+std::string Generator::generateSectionList(const Page &page) {
+    std::stringstream html;
+
+    html << "        <h2>Sections</h2>\n"
+            << "        <ul class=\"section-list\">\n";
+    for (const auto &section: page.sections) {
+        html << "            <li><a href=\"" << section.id << ".html\">" << section.title << "</a></li>\n";
+    }
+    html << "        </ul>\n";
+
+    return html.str();
+}
+
+std::string Generator::generatePageLinks(const Page *previous, const Page *next) {
+    std::stringstream html;
+
+    html << "        <nav class=\"page-nav\">\n";
+    if (previous) {
+        html << "            <a class=\"page-nav-prev\" href=\"" << previous->id << ".html\">&larr; "
+                << previous->title << "</a>\n";
+    }
+    if (next) {
+        html << "            <a class=\"page-nav-next\" href=\"" << next->id << ".html\">"
+                << next->title << " &rarr;</a>\n";
+    }
+    html << "        </nav>\n";
+
+    return html.str();
+}
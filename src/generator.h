@@ -4,13 +4,19 @@
 #include <string>
 #include <vector>
 #include <filesystem>
+#include <fstream>
 
 namespace fs = std::filesystem;
 
 struct Page {
     std::string id;
+    std::string source; // stem of the markdown file, which can differ from id after a clash
     std::string title;
     std::string content;
+    std::string contentFile; // when set, content is streamed from this file instead
+    std::vector<Page> sections; // sub-pages when the page was split at its H2 headings
+    std::vector<std::string> anchors; // heading slugs on this page
+    std::vector<std::string> links;   // link targets of the whole source file, on the top-level page only
 };
 
 class Generator {
@@ -20,10 +26,17 @@ class Generator {
               const std::string& cssTemplatePath = "templates/style.css",
               const std::string& jsTemplatePath = "templates/script.js");
     void addPage(const std::string& id, const std::string& title, const std::string& content);
+    void addPage(const Page& page);
     void generate();
 
-    void createStylesheet() const;
-    void createScripts() const;
+    // inline the stylesheet into every page head instead of linking it
+    void setInlineStylesheet(bool inlineStylesheet);
+
+    void createStylesheet();
+    void createScripts();
+
+    // template files are read once per process and shared by all generators
+    static const std::string* loadTemplate(const std::string& path);
 
 private:
     std::string manualTitle;
@@ -32,10 +45,24 @@ private:
     std::string cssTemplatePath;
     std::string jsTemplatePath;
     std::vector<Page> pages;
-    
+    bool inlineStylesheet = false;
+    std::string stylesheetUrl = "css/style.css";
+    std::string scriptUrl = "js/script.js";
+    std::string inlineCss;
+
+    [[nodiscard]] std::string writeAsset(const std::string& directory, const std::string& name,
+                                         const std::string& extension, const std::string& content) const;
+    [[nodiscard]] std::string generateStylesheetTag() const;
+
     void createIndexPage();
     void createContentPages();
+    void writeContentPage(const Page& page, const std::string& heading, const std::string& footer);
+    static void writeMainContent(std::ostream& out, const Page& page, const std::string& heading,
+                                 const std::string& footer);
+    [[nodiscard]] std::ofstream openFragment(const std::string& pageId, const std::string& documentTitle) const;
     std::string generateNavigation(const std::string& currentPageId);
+    static std::string generateSectionList(const Page& page);
+    static std::string generatePageLinks(const Page* previous, const Page* next);
 };
 
 #endif
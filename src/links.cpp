@@ -0,0 +1,194 @@
+#include "links.h"
+#include <fstream>
+#include <regex>
+#include <stdexcept>
+#include <unordered_set>
+
+LinkIndex::LinkIndex() {
+    addPageId("index", "");
+}
+
+void LinkIndex::addPageId(const std::string &pageId, const std::string &fileId) {
+    if (!pageFiles.emplace(pageId, fileId).second) {
+        throw std::runtime_error("Page id used more than once: " + pageId + ".html");
+    }
+}
+
+void LinkIndex::addPage(const Page &page) {
+    addPageId(page.id, page.id);
+    markdownFiles.emplace(page.source.empty() ? page.id : page.source, page.id);
+    for (const auto &slug: page.anchors) {
+        anchors.emplace(page.id + "#" + slug, page.id);
+    }
+
+    // anchors of split pages point at the section holding the heading
+    for (const auto &section: page.sections) {
+        addPageId(section.id, page.id);
+        for (const auto &slug: section.anchors) {
+            anchors.emplace(page.id + "#" + slug, section.id);
+        }
+    }
+}
+
+std::vector<std::string> LinkIndex::resolvePage(Page &page) const {
+    std::vector<std::string> broken;
+    std::unordered_map<std::string, std::string> urls;
+    std::unordered_map<std::string, std::string> anchorPages;
+    std::unordered_set<std::string> seen;
+
+    for (const auto &target: page.links) {
+        if (!seen.insert(target).second) {
+            continue;
+        }
+
+        std::string url;
+        if (!resolve(page.id, target, url)) {
+            broken.push_back(target);
+        }
+        else if (url != target) {
+            urls.emplace(target, url);
+        }
+        else if (!page.sections.empty() && target.size() > 1 && target[0] == '#') {
+            // the heading may live in another section of this split page
+            anchorPages.emplace(target, *findAnchor(page.id, target.substr(1)));
+        }
+    }
+
+    // only touch the content when some link actually changes
+    if (!urls.empty() || !anchorPages.empty()) {
+        if (!page.contentFile.empty()) {
+            rewriteContentFile(page.contentFile, urls);
+        }
+        else {
+            page.content = rewriteLinks(page.content, urls, anchorPages, page.id);
+        }
+
+        for (auto &section: page.sections) {
+            section.content = rewriteLinks(section.content, urls, anchorPages, section.id);
+        }
+    }
+
+    return broken;
+}
+
+bool LinkIndex::resolve(const std::string &fileId, const std::string &target, std::string &url) const {
+    url = target;
+
+    // external links and absolute paths are left alone
+    static const std::regex schemeRegex("^[A-Za-z][A-Za-z0-9+.-]*:");
+    if (target.empty() || target[0] == '/' || std::regex_search(target, schemeRegex)) {
+        return true;
+    }
+
+    const size_t hash = target.find('#');
+    std::string path = target.substr(0, hash);
+
+    // "./02-setup.md" names the same file as "02-setup.md"
+    while (path.compare(0, 2, "./") == 0) {
+        path.erase(0, 2);
+    }
+    const std::string slug = hash == std::string::npos ? "" : target.substr(hash + 1);
+
+    // anchor on the same page
+    if (path.empty()) {
+        return slug.empty() || findAnchor(fileId, slug) != nullptr;
+    }
+
+    // input directories are flat, so anything in another directory is outside the manual
+    if (path.find('/') != std::string::npos) {
+        return true;
+    }
+
+    const bool markdownLink = path.size() > 3 && path.compare(path.size() - 3, 3, ".md") == 0;
+    const bool htmlLink = path.size() > 5 && path.compare(path.size() - 5, 5, ".html") == 0;
+
+    // not a page of the manual, e.g. an image or a download
+    if (!markdownLink && !htmlLink) {
+        return true;
+    }
+
+    // markdown links name a source file, html links any generated page
+    const std::string name = path.substr(0, path.size() - (markdownLink ? 3 : 5));
+    const auto &table = markdownLink ? markdownFiles : pageFiles;
+    const auto page = table.find(name);
+    if (page == table.end()) {
+        return false;
+    }
+
+    const std::string &targetFile = page->second;
+
+    if (slug.empty()) {
+        if (markdownLink) {
+            url = targetFile + ".html";
+        }
+        return true;
+    }
+
+    const std::string *pageId = findAnchor(targetFile, slug);
+    if (!pageId) {
+        return false;
+    }
+
+    url = *pageId + ".html#" + slug;
+    return true;
+}
+
+const std::string *LinkIndex::findAnchor(const std::string &fileId, const std::string &slug) const {
+    const auto it = anchors.find(fileId + "#" + slug);
+    return it != anchors.end() ? &it->second : nullptr;
+}
+
+std::string LinkIndex::rewriteLinks(const std::string &html, const std::unordered_map<std::string, std::string> &urls,
+                                   const std::unordered_map<std::string, std::string> &anchorPages,
+                                   const std::string &currentPageId) {
+    static const std::regex hrefRegex("<a href=\"([^\"]*)\"");
+
+    std::string result;
+    auto last = html.cbegin();
+    for (std::sregex_iterator it(html.begin(), html.end(), hrefRegex), end; it != end; ++it) {
+        const auto &match = *it;
+        result.append(last, match[0].first);
+
+        const std::string target = match[1].str();
+        const auto url = urls.find(target);
+        const auto anchorPage = anchorPages.find(target);
+        if (url != urls.end()) {
+            result += "<a href=\"" + url->second + "\"";
+        }
+        else if (anchorPage != anchorPages.end() && anchorPage->second != currentPageId) {
+            result += "<a href=\"" + anchorPage->second + ".html" + target + "\"";
+        }
+        else {
+            result += match[0].str();
+        }
+        last = match[0].second;
+    }
+    result.append(last, html.cend());
+
+    return result;
+}
+
+void LinkIndex::rewriteContentFile(const std::string &path, const std::unordered_map<std::string, std::string> &urls) {
+    // rewrite line by line so streamed content is never loaded whole
+    const std::string rewrittenPath = path + ".links";
+    {
+        std::ifstream input(path);
+        std::ofstream output(rewrittenPath);
+        if (!input || !output) {
+            output.close();
+            std::error_code error;
+            fs::remove(rewrittenPath, error);
+            throw std::runtime_error("Could not rewrite links in: " + path);
+        }
+
+        std::string line;
+        while (std::getline(input, line)) {
+            output << rewriteLinks(line, urls);
+            if (!input.eof()) {
+                output << '\n';
+            }
+        }
+    }
+
+    fs::rename(rewrittenPath, path);
+}
@@ -0,0 +1,43 @@
+#ifndef LINKS_H
+#define LINKS_H
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include "generator.h"
+
+// manual-wide symbol table of generated pages and heading anchors, used to resolve
+// links between markdown files to their generated URLs and to find dangling ones
+class LinkIndex {
+public:
+    LinkIndex();
+
+    // registers a top-level page together with its sections. page ids must already be unique;
+    // a duplicate throws as a guard
+    void addPage(const Page& page);
+
+    // rewrites the links of a page (and its sections) to their generated URLs, including
+    // same-file anchors whose heading ended up in another section of a split page.
+    // returns the targets that do not exist in the manual
+    std::vector<std::string> resolvePage(Page& page) const;
+
+private:
+    std::unordered_map<std::string, std::string> pageFiles; // generated page id -> source file id
+    std::unordered_map<std::string, std::string> anchors;   // "file id#slug" -> generated page id
+    std::unordered_map<std::string, std::string> markdownFiles; // markdown file stem -> file id
+
+    void addPageId(const std::string& pageId, const std::string& fileId);
+    bool resolve(const std::string& fileId, const std::string& target, std::string& url) const;
+    [[nodiscard]] const std::string* findAnchor(const std::string& fileId, const std::string& slug) const;
+
+    // anchorPages maps same-file "#slug" links to the page holding the heading; they are only
+    // rewritten on pages other than currentPageId
+    static std::string rewriteLinks(const std::string& html,
+                                    const std::unordered_map<std::string, std::string>& urls,
+                                    const std::unordered_map<std::string, std::string>& anchorPages = {},
+                                    const std::string& currentPageId = "");
+    static void rewriteContentFile(const std::string& path,
+                                   const std::unordered_map<std::string, std::string>& urls);
+};
+
+#endif
@@ -1,86 +1,152 @@
+#include <algorithm>
 #include <iostream>
 #include <string>
 #include <vector>
+#include <thread>
 #include <filesystem>
-#include "parser.h"
-#include "converter.h"
-#include "generator.h"
+#include "batch.h"
 
 namespace fs = std::filesystem;
 
 void printUsage(const char *programName) {
-    std::cout << "Usage: " << programName << " <input_dir> <output_dir> [title] [author]" << std::endl;
+    std::cout << "Usage: " << programName << " [options] <input_dir> <output_dir> [title] [author]" << std::endl;
+    std::cout << "       " << programName << " [options] --manifest <file>" << std::endl;
     std::cout << "  input_dir: Directory containing markdown files" << std::endl;
     std::cout << "  output_dir: Directory where the HTML manual will be generated" << std::endl;
     std::cout << "  title: (Optional) Title of the manual (default: \"Reference Manual\")" << std::endl;
     std::cout << "  author: (Optional) Author name (default: none)" << std::endl;
+    std::cout << "Options:" << std::endl;
+    std::cout << "  --manifest <file>: Build every manual listed in the file, one tab-separated" << std::endl;
+    std::cout << "                     <input_dir> <output_dir> [title] [author] entry per line" << std::endl;
+    std::cout << "  --jobs <n>: Number of worker threads (default: number of CPU cores)" << std::endl;
+    std::cout << "  --stream: Convert each file in fixed-size chunks instead of loading it whole" << std::endl;
+    std::cout << "            (heading anchors and link targets are still kept for link checking)" << std::endl;
+    std::cout << "  --split-bytes <n>: Split pages larger than n bytes into one sub-page per H2 section" << std::endl;
+    std::cout << "  --split-headings <n>: Split pages with more than n H2 sections into sub-pages" << std::endl;
+    std::cout << "  --strict-links: Fail when a link points to a missing page or heading" << std::endl;
+    std::cout << "  --inline-css: Embed the stylesheet in every page instead of linking it" << std::endl;
 }
 
 int main(int argc, char *argv[]) {
-    if (argc < 3) {
-        printUsage(argv[0]);
-        return 1;
-    }
+    // separate options from positional arguments
+    std::vector<std::string> args;
+    BuildOptions options;
+    std::string manifestPath;
+    size_t workerCount = std::thread::hardware_concurrency();
 
-    std::string inputDir = argv[1];
-    std::string outputDir = argv[2];
-    std::string title = argc > 3 ? argv[3] : "Reference Manual";
-    std::string author = argc > 4 ? argv[4] : "";
+    for (int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+        if (arg == "--stream") {
+            options.streaming = true;
+        }
+        else if (arg == "--strict-links") {
+            options.strictLinks = true;
+        }
+        else if (arg == "--inline-css") {
+            options.inlineCss = true;
+        }
+        else if (arg == "--manifest" || arg == "--jobs" || arg == "--split-bytes" || arg == "--split-headings") {
+            if (i + 1 >= argc) {
+                std::cerr << "Error: Missing value for option: " << arg << std::endl;
+                return 1;
+            }
+            const std::string value = argv[++i];
 
-    // Check if input directory exists
-    if (!fs::exists(inputDir) || !fs::is_directory(inputDir)) {
-        std::cerr << "Error: Input directory does not exist or is not a directory." << std::endl;
-        return 1;
-    }
+            if (arg == "--manifest") {
+                manifestPath = value;
+                continue;
+            }
 
-    // Create output directory if it doesn't exist
-    if (!fs::exists(outputDir)) {
-        if (!fs::create_directories(outputDir)) {
-            std::cerr << "Error: Could not create output directory." << std::endl;
+            try {
+                const size_t number = std::stoul(value);
+                if (arg == "--jobs") {
+                    workerCount = number;
+                }
+                else {
+                    (arg == "--split-bytes" ? options.split.maxBytes : options.split.maxSections) = number;
+                }
+            }
+            catch (const std::exception &) {
+                std::cerr << "Error: Invalid value for option " << arg << ": " << value << std::endl;
+                return 1;
+            }
+        }
+        else if (arg.rfind("--", 0) == 0) {
+            std::cerr << "Error: Unknown option: " << arg << std::endl;
+            printUsage(argv[0]);
             return 1;
         }
+        else {
+            args.push_back(arg);
+        }
     }
 
-    // Collect markdown files
-    std::vector<std::string> mdFiles;
-    for (const auto &entry: fs::directory_iterator(inputDir)) {
-        if (entry.is_regular_file() && entry.path().extension() == ".md") {
-            mdFiles.push_back(entry.path().string());
-        }
+    const bool batchMode = !manifestPath.empty();
+    if ((batchMode && !args.empty()) || (!batchMode && args.size() < 2)) {
+        printUsage(argv[0]);
+        return 1;
     }
 
-    if (mdFiles.empty()) {
-        std::cerr << "Error: No markdown files found in the input directory." << std::endl;
+    // splitting works on the whole document tree, which streaming never builds
+    if (options.streaming && options.split.enabled()) {
+        std::cerr << "Error: --stream cannot be combined with --split-bytes or --split-headings." << std::endl;
         return 1;
     }
 
-    try {
-        Generator generator(title, outputDir, author);
+    std::vector<ManualJob> jobs;
+    if (batchMode) {
+        try {
+            jobs = BatchRunner::readManifest(manifestPath);
+        }
+        catch (const std::exception &e) {
+            std::cerr << "Error: " << e.what() << std::endl;
+            return 1;
+        }
+    }
+    else {
+        ManualJob job;
+        job.inputDir = args[0];
+        job.outputDir = args[1];
+        if (args.size() > 2) {
+            job.title = args[2];
+        }
+        if (args.size() > 3) {
+            job.author = args[3];
+        }
+        jobs.push_back(job);
+    }
 
-        for (const auto &mdFile: mdFiles) {
-            // Parse markdown file
-            Parser parser(mdFile);
-            auto mdContent = parser.parse();
+    const BatchRunner runner(options, workerCount);
+    const auto results = runner.run(jobs);
 
-            // Convert markdown to HTML
-            Converter converter;
-            auto htmlContent = converter.convert(mdContent);
+    size_t failures = 0;
+    double totalMilliseconds = 0;
+    for (const auto &result: results) {
+        totalMilliseconds = std::max(totalMilliseconds, result.finishedMilliseconds);
 
-            // Add page to the generator
-            fs::path filePath(mdFile);
-            std::string pageName = filePath.stem().string();
-            generator.addPage(pageName, mdContent.title.empty() ? pageName : mdContent.title, htmlContent);
+        for (const auto &brokenLink: result.brokenLinks) {
+            std::cerr << "Warning: Broken link in " << (batchMode ? result.outputDir + ": " : "") << brokenLink
+                    << std::endl;
         }
 
-        // Generate the manual
-        generator.generate();
+        if (!result.error.empty()) {
+            failures++;
+            std::cerr << "Error: " << (batchMode ? result.outputDir + ": " : "") << result.error << std::endl;
+            continue;
+        }
 
-        std::cout << "Manual generated successfully in: " << outputDir << std::endl;
+        std::cout << "Manual generated successfully in: " << result.outputDir;
+        if (batchMode) {
+            std::cout << " (" << result.fileCount << " files, " << result.workMilliseconds << " ms work, finished after "
+                    << result.finishedMilliseconds << " ms)";
+        }
+        std::cout << std::endl;
     }
-    catch (const std::exception &e) {
-        std::cerr << "Error: " << e.what() << std::endl;
-        return 1;
+
+    if (batchMode) {
+        std::cout << "Built " << results.size() - failures << " of " << results.size() << " manuals in "
+                << totalMilliseconds << " ms" << std::endl;
     }
 
-    return 0;
+    return failures == 0 ? 0 : 1;
 }
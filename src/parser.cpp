@@ -3,6 +3,7 @@
 #include <sstream>
 #include <iostream>
 #include <regex>
+#include "utils.h"
 
 Parser::Parser(const std::string &filePath) : filePath(filePath) {
     readFile();
@@ -61,101 +62,27 @@ MarkdownElement Parser::parseParagraph(const std::string &content) {
     return element;
 }
 
-MarkdownElement Parser::parseCodeBlock(const std::vector<std::string> &lines, size_t &index) {
-    MarkdownElement element;
-    element.type = MarkdownElement::CODE_BLOCK;
-
-    // check if it's a fenced code block with language
-    const std::string& firstLine = lines[index];
-    const std::regex languageRegex("^```(\\w*)");
-    std::smatch matches;
-
-    if (std::regex_search(firstLine, matches, languageRegex) && matches.size() > 1) {
-        element.attributes["language"] = matches[1];
-    }
-
-    index++; // skip the opening fence
-
-    std::stringstream codeContent;
-    while (index < lines.size()) {
-        if (lines[index] == "```") {
-            index++; // skip the closing fence
-            break;
-        }
-
-        codeContent << lines[index] << '\n';
-        index++;
-    }
-
-    element.content = codeContent.str();
-
-    return element;
-}
-
-MarkdownElement Parser::parseList(const std::vector<std::string> &lines, size_t &index) {
-    MarkdownElement element;
-    element.type = MarkdownElement::LIST;
-
-    // determine if it's an ordered or unordered list
-    const bool isOrdered = std::regex_match(lines[index], std::regex(R"(^\d+\.\s.*)"));
-    element.attributes["ordered"] = isOrdered ? "true" : "false";
-
-    while (index < lines.size()) {
-        const std::string& line = lines[index];
-
-        // check if the line is a list item
-        const bool isListItem = std::regex_match(line, std::regex(R"(^[\*\-\+]\s.*)")) ||
-                          std::regex_match(line, std::regex(R"(^\d+\.\s.*)"));
-
-        if (!isListItem) {
-            break;
-        }
-
-        // extract list item content (remove marker and leading space)
-        size_t contentStart = 0;
-        if (std::regex_match(line, std::regex(R"(^\d+\.\s.*)"))) {
-            // For numbered lists, skip the number and dot
-            contentStart = line.find('.') + 1;
-        } else {
-            // For bullet lists, skip the marker
-            contentStart = line.find_first_of("*-+") + 1;
-        }
-        while (contentStart < line.size() && std::isspace(line[contentStart])) {
-            contentStart++;
-        }
-
-        MarkdownElement listItem;
-        listItem.type = MarkdownElement::LIST_ITEM;
-        listItem.content = parseInlineMarkdown(line.substr(contentStart));
-
-        element.children.push_back(listItem);
-        index++;
-    }
-
-    return element;
-}
-
 std::string Parser::parseInlineMarkdown(const std::string &text) {
     std::string result = text;
 
     // handle bold text
-    const std::regex boldRegex(R"(\*\*(.*?)\*\*|__(.*?)__)");
+    static const std::regex boldRegex(R"(\*\*(.*?)\*\*|__(.*?)__)");
     result = std::regex_replace(result, boldRegex, "<strong>$1$2</strong>");
 
     // handle italic text
-    const std::regex italicRegex("\\*(.*?)\\*|_(.*?)_");
+    static const std::regex italicRegex("\\*(.*?)\\*|_(.*?)_");
     result = std::regex_replace(result, italicRegex, "<em>$1$2</em>");
 
     // handle inline code
-    const std::regex codeRegex("`(.*?)`");
+    static const std::regex codeRegex("`(.*?)`");
     result = std::regex_replace(result, codeRegex, "<code>$1</code>");
 
     // handle links
-    const std::regex linkRegex(R"(\[(.*?)\]\((.*?)\))");
+    static const std::regex linkRegex(R"(\[(.*?)\]\((.*?)\))");
     result = std::regex_replace(result, linkRegex, "<a href=\"$2\">$1</a>");
 
     // handle images
-    const std::regex imageRegex(R"(!\[(.*?)\]\((.*?)\))");
+    static const std::regex imageRegex(R"(!\[(.*?)\]\((.*?)\))");
     result = std::regex_replace(result, imageRegex, R"(<img src="$2" alt="$1">)");
 
     return result;
@@ -163,110 +90,235 @@ std::string Parser::parseInlineMarkdown(const std::string &text) {
 
 MarkdownDocument Parser::parse() const {
     MarkdownDocument document;
-    const std::vector<std::string> lines = splitLines();
-
-    bool hasParagraphContent = false;
-    std::string currentParagraph;
+    BlockParser blockParser([&document](MarkdownElement &&element) {
+        document.elements.push_back(std::move(element));
+    });
 
-    for (size_t i = 0; i < lines.size(); i++) {
-        const std::string& line = lines[i];
+    for (const auto &line: splitLines()) {
+        blockParser.feedLine(line);
+    }
+    blockParser.finish();
 
-        // skip empty lines
-        if (line.empty()) {
-            if (hasParagraphContent) {
-                document.elements.push_back(parseParagraph(currentParagraph));
-                currentParagraph.clear();
-                hasParagraphContent = false;
-            }
-            continue;
-        }
+    document.title = blockParser.title();
+    document.anchors = blockParser.anchors();
+    document.links = blockParser.links();
+    return document;
+}
 
-        // check for heading
-        if (line[0] == '#') {
-            if (hasParagraphContent) {
-                document.elements.push_back(parseParagraph(currentParagraph));
-                currentParagraph.clear();
-                hasParagraphContent = false;
-            }
+MarkdownDocument Parser::parseStream(const std::string &filePath, const ElementHandler &onElement, size_t chunkSize) {
+    // text mode like readFile, so both paths see the same line endings
+    std::ifstream file(filePath);
+    if (!file.is_open()) {
+        throw std::runtime_error("Could not open file: " + filePath);
+    }
 
-            MarkdownElement heading = parseHeading(line);
-            document.elements.push_back(heading);
+    BlockParser blockParser(onElement);
+    std::vector<char> chunk(chunkSize);
+    std::string line;
 
-            // use the first heading as the document title
-            if (heading.level == 1 && document.title.empty()) {
-                document.title = heading.content;
+    // split each chunk into lines, carrying a partial line over to the next chunk
+    while (file.read(chunk.data(), static_cast<std::streamsize>(chunk.size())) || file.gcount() > 0) {
+        const auto count = static_cast<size_t>(file.gcount());
+        size_t lineStart = 0;
+
+        for (size_t i = 0; i < count; i++) {
+            if (chunk[i] == '\n') {
+                line.append(chunk.data() + lineStart, i - lineStart);
+                blockParser.feedLine(line);
+                line.clear();
+                lineStart = i + 1;
             }
-
-            continue;
         }
+        line.append(chunk.data() + lineStart, count - lineStart);
+    }
 
-        // check for code block
-        if (line == "```" || line.substr(0, 3) == "```") {
-            if (hasParagraphContent) {
-                document.elements.push_back(parseParagraph(currentParagraph));
-                currentParagraph.clear();
-                hasParagraphContent = false;
-            }
+    // a trailing line without a newline still counts, matching std::getline
+    if (!line.empty()) {
+        blockParser.feedLine(line);
+    }
+    blockParser.finish();
 
-            document.elements.push_back(parseCodeBlock(lines, i));
-            i--; // index is already advanced in parseCodeBlock
-            continue;
-        }
+    MarkdownDocument document;
+    document.title = blockParser.title();
+    document.anchors = blockParser.anchors();
+    document.links = blockParser.links();
+    return document;
+}
 
-        // check for list
-        if ((line[0] == '*' || line[0] == '-' || line[0] == '+') && line.size() > 1 && std::isspace(line[1])) {
-            if (hasParagraphContent) {
-                document.elements.push_back(parseParagraph(currentParagraph));
-                currentParagraph.clear();
-                hasParagraphContent = false;
-            }
+BlockParser::BlockParser(ElementHandler onElement) : onElement(std::move(onElement)) {
+}
 
-            document.elements.push_back(parseList(lines, i));
-            i--; // index is already advanced in parseList
-            continue;
-        }
+void BlockParser::emit(MarkdownElement &&element) {
+    // use the first heading as the document title
+    if (element.type == MarkdownElement::HEADING && element.level == 1 && documentTitle.empty()) {
+        documentTitle = element.content;
+    }
 
-        // check for ordered list
-        if (std::regex_match(line, std::regex(R"(^\d+\.\s.*)"))) {
-            if (hasParagraphContent) {
-                document.elements.push_back(parseParagraph(currentParagraph));
-                currentParagraph.clear();
-                hasParagraphContent = false;
-            }
+    // record heading anchors and link targets for cross-page link resolution
+    if (element.type == MarkdownElement::HEADING) {
+        documentAnchors.push_back(utils::slugify(element.content));
+    }
+    recordLinks(element);
 
-            document.elements.push_back(parseList(lines, i));
-            i--; // index is already advanced in parseList
-            continue;
-        }
+    onElement(std::move(element));
+}
 
-        // check for horizontal rule
-        if (line == "---" || line == "***" || line == "___") {
-            if (hasParagraphContent) {
-                document.elements.push_back(parseParagraph(currentParagraph));
-                currentParagraph.clear();
-                hasParagraphContent = false;
-            }
+void BlockParser::recordLinks(const MarkdownElement &element) {
+    static const std::regex hrefRegex("<a href=\"([^\"]*)\"");
 
-            MarkdownElement hr;
-            hr.type = MarkdownElement::HORIZONTAL_RULE;
-            document.elements.push_back(hr);
-            continue;
-        }
+    for (std::sregex_iterator it(element.content.begin(), element.content.end(), hrefRegex), end; it != end; ++it) {
+        documentLinks.push_back((*it)[1].str());
+    }
+    for (const auto &child: element.children) {
+        recordLinks(child);
+    }
+}
 
-        // if we get here, it's part of a paragraph
-        if (hasParagraphContent) {
-            currentParagraph += " " + line;
+void BlockParser::closeBlock() {
+    switch (state) {
+        case PARAGRAPH:
+            emit(Parser::parseParagraph(currentParagraph));
+            currentParagraph.clear();
+            break;
+        case CODE_BLOCK:
+        case LIST:
+            emit(std::move(currentBlock));
+            currentBlock = MarkdownElement();
+            break;
+        case NONE:
+            break;
+    }
+
+    state = NONE;
+}
+
+void BlockParser::feedLine(const std::string &line) {
+    // inside a fenced code block everything up to the closing fence is literal
+    if (state == CODE_BLOCK) {
+        if (line == "```") {
+            closeBlock();
         }
         else {
-            currentParagraph = line;
-            hasParagraphContent = true;
+            currentBlock.content += line;
+            currentBlock.content += '\n';
         }
+        return;
     }
 
-    // add the last paragraph if there is one
-    if (hasParagraphContent) {
-        document.elements.push_back(parseParagraph(currentParagraph));
+    // a list continues for as long as consecutive lines are list items
+    if (state == LIST) {
+        if (isListItem(line)) {
+            addListItem(line);
+            return;
+        }
+        closeBlock();
     }
 
-    return document;
+    // empty lines end the current paragraph
+    if (line.empty()) {
+        closeBlock();
+        return;
+    }
+
+    // check for heading
+    if (line[0] == '#') {
+        closeBlock();
+        emit(Parser::parseHeading(line));
+        return;
+    }
+
+    // check for code block
+    if (line.compare(0, 3, "```") == 0) {
+        closeBlock();
+        startCodeBlock(line);
+        return;
+    }
+
+    // check for ordered or unordered list
+    if (isListItem(line)) {
+        closeBlock();
+        startList(line);
+        return;
+    }
+
+    // check for horizontal rule
+    if (line == "---" || line == "***" || line == "___") {
+        closeBlock();
+
+        MarkdownElement hr;
+        hr.type = MarkdownElement::HORIZONTAL_RULE;
+        emit(std::move(hr));
+        return;
+    }
+
+    // if we get here, it's part of a paragraph
+    if (state == PARAGRAPH) {
+        currentParagraph += " " + line;
+    }
+    else {
+        currentParagraph = line;
+        state = PARAGRAPH;
+    }
+}
+
+void BlockParser::finish() {
+    // an unterminated code block or a trailing paragraph still gets emitted
+    closeBlock();
+}
+
+void BlockParser::startCodeBlock(const std::string &line) {
+    currentBlock = MarkdownElement();
+    currentBlock.type = MarkdownElement::CODE_BLOCK;
+
+    // check if it's a fenced code block with language
+    static const std::regex languageRegex("^```(\\w*)");
+    std::smatch matches;
+
+    if (std::regex_search(line, matches, languageRegex) && matches.size() > 1) {
+        currentBlock.attributes["language"] = matches[1];
+    }
+
+    state = CODE_BLOCK;
+}
+
+void BlockParser::startList(const std::string &line) {
+    currentBlock = MarkdownElement();
+    currentBlock.type = MarkdownElement::LIST;
+
+    // determine if it's an ordered or unordered list
+    currentBlock.attributes["ordered"] = isOrderedListItem(line) ? "true" : "false";
+
+    state = LIST;
+    addListItem(line);
+}
+
+void BlockParser::addListItem(const std::string &line) {
+    // extract list item content (remove marker and leading space)
+    size_t contentStart = 0;
+    if (isOrderedListItem(line)) {
+        // For numbered lists, skip the number and dot
+        contentStart = line.find('.') + 1;
+    } else {
+        // For bullet lists, skip the marker
+        contentStart = line.find_first_of("*-+") + 1;
+    }
+    while (contentStart < line.size() && std::isspace(line[contentStart])) {
+        contentStart++;
+    }
+
+    MarkdownElement listItem;
+    listItem.type = MarkdownElement::LIST_ITEM;
+    listItem.content = Parser::parseInlineMarkdown(line.substr(contentStart));
+
+    currentBlock.children.push_back(std::move(listItem));
+}
+
+bool BlockParser::isListItem(const std::string &line) {
+    static const std::regex bulletRegex(R"(^[\*\-\+]\s.*)");
+    return std::regex_match(line, bulletRegex) || isOrderedListItem(line);
+}
+
+bool BlockParser::isOrderedListItem(const std::string &line) {
+    static const std::regex orderedRegex(R"(^\d+\.\s.*)");
+    return std::regex_match(line, orderedRegex);
 }
@@ -3,6 +3,7 @@
 
 #include <string>
 #include <vector>
+#include <functional>
 #include <unordered_map>
 
 // represents a structural element in markdown
@@ -30,6 +31,53 @@ struct MarkdownElement {
 struct MarkdownDocument {
     std::string title;
     std::vector<MarkdownElement> elements;
+    std::vector<std::string> anchors; // heading slugs, in document order
+    std::vector<std::string> links;   // link targets, in document order
+};
+
+// receives each block element as soon as it is complete
+using ElementHandler = std::function<void(MarkdownElement&&)>;
+
+// line-driven block parser shared by the batch and streaming paths.
+// only the block currently being built is held in memory, plus the heading
+// anchors and link targets of the document, which grow with their count
+class BlockParser {
+public:
+    explicit BlockParser(ElementHandler onElement);
+
+    void feedLine(const std::string& line);
+    void finish();
+
+    [[nodiscard]] const std::string& title() const { return documentTitle; }
+    [[nodiscard]] const std::vector<std::string>& anchors() const { return documentAnchors; }
+    [[nodiscard]] const std::vector<std::string>& links() const { return documentLinks; }
+
+private:
+    enum State {
+        NONE,
+        PARAGRAPH,
+        CODE_BLOCK,
+        LIST
+    };
+
+    ElementHandler onElement;
+    State state = NONE;
+    std::string documentTitle;
+    std::vector<std::string> documentAnchors;
+    std::vector<std::string> documentLinks;
+    std::string currentParagraph;
+    MarkdownElement currentBlock;
+
+    void emit(MarkdownElement&& element);
+    void recordLinks(const MarkdownElement& element);
+    void closeBlock();
+
+    void startCodeBlock(const std::string& line);
+    void startList(const std::string& line);
+    void addListItem(const std::string& line);
+
+    static bool isListItem(const std::string& line);
+    static bool isOrderedListItem(const std::string& line);
 };
 
 class Parser {
@@ -37,6 +85,15 @@ public:
     explicit Parser(const std::string& filePath);
     [[nodiscard]] MarkdownDocument parse() const;
 
+    // reads the file in fixed-size chunks and hands each block element to the
+    // callback as soon as it closes. returns the document without its elements
+    static MarkdownDocument parseStream(const std::string& filePath, const ElementHandler& onElement,
+                                   size_t chunkSize = 64 * 1024);
+
+    static MarkdownElement parseHeading(const std::string& line);
+    static MarkdownElement parseParagraph(const std::string& content);
+    static std::string parseInlineMarkdown(const std::string& text);
+
 private:
     std::string filePath;
     std::string content;
@@ -44,13 +101,6 @@ private:
     void readFile();
 
     [[nodiscard]] std::vector<std::string> splitLines() const;
-
-    static MarkdownElement parseHeading(const std::string& line);
-    static MarkdownElement parseParagraph(const std::string& content);
-    static MarkdownElement parseCodeBlock(const std::vector<std::string>& lines, size_t& index);
-
-    static MarkdownElement parseList(const std::vector<std::string>& lines, size_t& index);
-    static std::string parseInlineMarkdown(const std::string& text);
 };
 
 #endif
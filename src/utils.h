@@ -4,6 +4,7 @@
 #include <string>
 #include <algorithm>
 #include <cctype>
+#include <cstdint>
 #include <regex>
 
 namespace utils {
@@ -19,7 +20,8 @@ inline std::string toLowercase(const std::string& str) {
 // generate a slug (URL-friendly string) from text
 inline std::string slugify(const std::string& text) {
     // remove HTML tags
-    std::string result = std::regex_replace(text, std::regex("<[^>]*>"), "");
+    static const std::regex tagRegex("<[^>]*>");
+    std::string result = std::regex_replace(text, tagRegex, "");
     
     // convert to lowercase
     result = toLowercase(result);
@@ -35,7 +37,8 @@ inline std::string slugify(const std::string& text) {
                  result.end());
     
     // replace multiple hyphens with a single hyphen
-    result = std::regex_replace(result, std::regex("--+"), "-");
+    static const std::regex hyphensRegex("--+");
+    result = std::regex_replace(result, hyphensRegex, "-");
     
     // remove leading and trailing hyphens
     if (!result.empty() && result.front() == '-') {
@@ -48,6 +51,41 @@ inline std::string slugify(const std::string& text) {
     return result;
 }
 
+// escape text for use inside an HTML attribute value
+inline std::string escapeHtml(const std::string& text) {
+    std::string result;
+    result.reserve(text.size());
+
+    for (const char c : text) {
+        switch (c) {
+            case '&': result += "&amp;"; break;
+            case '<': result += "&lt;"; break;
+            case '>': result += "&gt;"; break;
+            case '"': result += "&quot;"; break;
+            default: result += c; break;
+        }
+    }
+
+    return result;
+}
+
+// short hex digest of the content (64-bit FNV-1a), used to fingerprint file names
+inline std::string contentHash(const std::string& content) {
+    uint64_t hash = 14695981039346656037ULL;
+    for (const unsigned char c : content) {
+        hash ^= c;
+        hash *= 1099511628211ULL;
+    }
+
+    static const char digits[] = "0123456789abcdef";
+    std::string result(8, '0');
+    for (size_t i = 0; i < result.size(); i++) {
+        result[i] = digits[(hash >> (60 - 4 * i)) & 0xf];
+    }
+
+    return result;
+}
+
 } // namespace utils
 
 #endif
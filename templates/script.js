@@ -1,39 +1,205 @@
-document.addEventListener('DOMContentLoaded', function() {
-    // highlight the active page in navigation
+// highlight the active page in navigation
+function highlightActiveLink() {
     const currentPath = window.location.pathname;
-    const currentPage = currentPath.split('/').pop();
+    const currentPage = currentPath.split('/').pop() || 'index.html';
     const navLinks = document.querySelectorAll('.nav-link');
-    
+
     navLinks.forEach(link => {
-        if (link.getAttribute('href') === currentPage) {
-            link.classList.add('active');
-        }
+        link.classList.toggle('active', link.getAttribute('href') === currentPage);
     });
-    
-    // generate table of contents if available
+}
+
+// generate table of contents if available
+function buildTableOfContents() {
     const headings = document.querySelectorAll('.content h2, .content h3, .content h4');
     const tocContainer = document.getElementById('toc');
-    
+
     if (tocContainer && headings.length > 0) {
         const tocTitle = document.createElement('h2');
         tocTitle.textContent = 'Table of Contents';
         tocContainer.appendChild(tocTitle);
-        
+
         const tocList = document.createElement('ul');
         tocList.classList.add('toc-list');
-        
+
         headings.forEach(heading => {
             const listItem = document.createElement('li');
             listItem.classList.add('toc-item', `toc-${heading.tagName.toLowerCase()}`);
-            
+
             const link = document.createElement('a');
             link.textContent = heading.textContent;
             link.href = `#${heading.id}`;
-            
+
             listItem.appendChild(link);
             tocList.appendChild(listItem);
         });
-        
+
         tocContainer.appendChild(tocList);
     }
+}
+
+// instant navigation: swap the main content with a prefetched fragment instead of loading a full page.
+// full pages remain the fallback whenever a fragment cannot be used
+const fragmentCache = new Map();
+
+// path of the page whose content is currently shown
+let shownPath = window.location.pathname;
+
+// returns the page file name for links to other pages of this manual, or null
+function pageFileOf(link) {
+    if (link.target || link.hasAttribute('download') || link.origin !== window.location.origin) {
+        return null;
+    }
+
+    const base = window.location.pathname.substring(0, window.location.pathname.lastIndexOf('/') + 1);
+    if (!link.pathname.startsWith(base)) {
+        return null;
+    }
+
+    const file = link.pathname.substring(base.length);
+    return /^[^/]+\.html$/.test(file) ? file : null;
+}
+
+function fetchFragment(file) {
+    if (!fragmentCache.has(file)) {
+        const request = fetch(`fragments/${file}`).then(response => {
+            if (!response.ok) {
+                throw new Error(`Could not load fragment: ${file}`);
+            }
+            return response.text();
+        });
+
+        // forget failed requests so a later attempt can retry
+        request.catch(() => fragmentCache.delete(file));
+        fragmentCache.set(file, request);
+    }
+
+    return fragmentCache.get(file);
+}
+
+function prefetchLink(link) {
+    const file = pageFileOf(link);
+    if (file) {
+        fetchFragment(file).catch(() => {});
+    }
+}
+
+function showFragment(html, hash) {
+    const template = document.createElement('template');
+    template.innerHTML = html.trim();
+
+    const fragment = template.content.firstElementChild;
+    const current = document.querySelector('main.content');
+    if (!fragment || !current) {
+        return false;
+    }
+
+    document.title = fragment.dataset.title || document.title;
+    fragment.removeAttribute('data-title');
+    current.replaceWith(fragment);
+
+    highlightActiveLink();
+    buildTableOfContents();
+    observeLinks(fragment);
+
+    const target = hash ? document.getElementById(decodeURIComponent(hash.substring(1))) : null;
+    if (target) {
+        target.scrollIntoView();
+    }
+    else {
+        window.scrollTo(0, 0);
+    }
+
+    return true;
+}
+
+function navigate(url, pushHistory) {
+    const link = document.createElement('a');
+    link.href = url;
+    const file = pageFileOf(link);
+    if (!file) {
+        window.location.href = url;
+        return;
+    }
+
+    fetchFragment(file)
+        .then(html => {
+            if (pushHistory) {
+                history.pushState({}, '', url);
+            }
+            if (!showFragment(html, link.hash)) {
+                throw new Error('Invalid fragment');
+            }
+            shownPath = link.pathname;
+        })
+        .catch(() => {
+            window.location.href = url;
+        });
+}
+
+// prefetch fragments for links as they scroll into view
+const linkObserver = 'IntersectionObserver' in window ? new IntersectionObserver(entries => {
+    entries.forEach(entry => {
+        if (entry.isIntersecting) {
+            prefetchLink(entry.target);
+            linkObserver.unobserve(entry.target);
+        }
+    });
+}) : null;
+
+function observeLinks(root) {
+    if (linkObserver) {
+        root.querySelectorAll('a[href]').forEach(link => linkObserver.observe(link));
+    }
+}
+
+function enableInstantNavigation() {
+    // fragments are fetched over HTTP; opening the manual from disk keeps plain page loads
+    if (!window.location.protocol.startsWith('http') || !window.fetch || !window.history.pushState) {
+        return;
+    }
+
+    document.addEventListener('mouseover', event => {
+        const link = event.target.closest('a[href]');
+        if (link) {
+            prefetchLink(link);
+        }
+    });
+
+    document.addEventListener('click', event => {
+        const link = event.target.closest('a[href]');
+        if (!link || event.defaultPrevented || event.button !== 0 ||
+            event.metaKey || event.ctrlKey || event.shiftKey || event.altKey) {
+            return;
+        }
+
+        const file = pageFileOf(link);
+        if (!file) {
+            return;
+        }
+
+        // anchors within the current page keep the default scrolling behaviour
+        if (link.pathname === window.location.pathname && link.hash) {
+            return;
+        }
+
+        event.preventDefault();
+        navigate(link.href, true);
+    });
+
+    window.addEventListener('popstate', () => {
+        // history steps between anchors of the shown page are left to the browser's scroll restoration
+        if (window.location.pathname === shownPath) {
+            return;
+        }
+        navigate(window.location.href, false);
+    });
+
+    observeLinks(document);
+}
+
+document.addEventListener('DOMContentLoaded', function() {
+    highlightActiveLink();
+    buildTableOfContents();
+    enableInstantNavigation();
 });